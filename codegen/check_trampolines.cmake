@@ -0,0 +1,209 @@
+# Codegen regression check of `call_irq` trampolines
+#
+# Description:
+#  Disassembles an object file (or a static library) built from
+#  "trampolines.cpp" and checks every `call_irq` trampoline against
+#  budgets of its strategy. Strategy is taken from the holder name
+#  (`codegen::<Strategy>Holder`). Fails if any budget is exceeded or
+#  if some of the expected trampolines were not found.
+#
+# Usage:
+#  cmake -DOBJDUMP=<objdump> -DINPUT=<file> -DARCH=<x86_64|arm>
+#        [-DSTAMP=<file>] -P check_trampolines.cmake
+#
+# Budgets:
+#  `BUDGET_<ARCH>_<Strategy>` is a list of three numbers:
+#  max instructions, max direct calls, max indirect calls/jumps.
+#  Returns, nops and `endbr` landing pads are not counted.
+#
+#  A direct jump with a relocation to another function is a tail
+#  call, so it is counted as a call. The input is not linked, so such
+#  jumps are found by relocations (`objdump -r`), not by targets.
+#
+#  If some change makes a trampoline smaller, tighten the budget.
+#  If it makes it bigger, it is a regression: fix the code, not the budget.
+#
+
+#--> Budgets
+    set(BUDGET_x86_64_IrqHandlerFixed 2 0 0)
+    set(BUDGET_x86_64_MultiIrqHandlerFixed 2 0 0)
+    set(BUDGET_x86_64_IrqHandler 8 0 1)
+    set(BUDGET_x86_64_MultiIrqHandler 8 0 1)
+    set(BUDGET_x86_64_IrqHandlerArray 2 0 0)
+
+    # Cortex-M3, Thumb-2
+    set(BUDGET_arm_IrqHandlerFixed 4 0 0)
+    set(BUDGET_arm_MultiIrqHandlerFixed 4 0 0)
+    set(BUDGET_arm_IrqHandler 12 0 1)
+    set(BUDGET_arm_MultiIrqHandler 12 0 1)
+    set(BUDGET_arm_IrqHandlerArray 4 0 0)
+
+    # How many trampolines of each strategy "trampolines.cpp" has
+    set(EXPECTED_IrqHandlerFixed 1)
+    set(EXPECTED_MultiIrqHandlerFixed 2)
+    set(EXPECTED_IrqHandler 1)
+    set(EXPECTED_MultiIrqHandler 2)
+    set(EXPECTED_IrqHandlerArray 2)
+
+    set(STRATEGIES
+        IrqHandlerFixed
+        MultiIrqHandlerFixed
+        IrqHandler
+        MultiIrqHandler
+        IrqHandlerArray
+    )
+# <--
+
+foreach(var OBJDUMP INPUT ARCH)
+    if (NOT ${var})
+        message(FATAL_ERROR "${var} is not set")
+    endif()
+endforeach()
+
+if (NOT DEFINED BUDGET_${ARCH}_IrqHandlerFixed)
+    message(FATAL_ERROR "There are no budgets for `${ARCH}` architecture")
+endif()
+
+execute_process(
+    COMMAND ${OBJDUMP} -d -r -C --no-show-raw-insn ${INPUT}
+    OUTPUT_VARIABLE disasm
+    RESULT_VARIABLE result
+)
+
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "${OBJDUMP} failed on ${INPUT}")
+endif()
+
+# Make the output safe for CMake lists: `;` is a separator and
+# square brackets prevent splitting
+string(REPLACE ";" "," disasm "${disasm}")
+string(REPLACE "[" "(" disasm "${disasm}")
+string(REPLACE "]" ")" disasm "${disasm}")
+string(REPLACE "\n" ";" lines "${disasm}")
+
+if (ARCH STREQUAL "arm")
+    set(INDIRECT_REGEX "^(blx|bx)(\\.n|\\.w)?[ \t]+(r[0-9]+|ip|sb|sl|fp)|^(ldr|mov)[a-z.]*[ \t]+pc,")
+    set(CALL_REGEX "^bl(\\.n|\\.w)?[ \t]|^blx(\\.n|\\.w)?[ \t]+[0-9a-f]")
+    set(RETURN_REGEX "^bx(\\.n|\\.w)?[ \t]+lr|^pop(\\.n|\\.w)?[ \t].*pc")
+    set(JUMP_REGEX "^b(eq|ne|cs|cc|hs|lo|mi|pl|vs|vc|hi|ls|ge|lt|gt|le|al)?(\\.n|\\.w)?[ \t]")
+    set(CALL_RELOCATION_REGEX "^R_ARM_(THM_)?(JUMP24|JUMP19|CALL|PC22)$")
+else()
+    set(INDIRECT_REGEX "^(call|jmp)[a-z]*[ \t]+\\*")
+    set(CALL_REGEX "^call")
+    set(RETURN_REGEX "^ret")
+    set(JUMP_REGEX "^j[a-z]*[ \t]+[^* \t]")
+    set(CALL_RELOCATION_REGEX "^R_X86_64_(PLT32|PC32)$")
+endif()
+
+set(TRAMPOLINE_REGEX
+    "::(IrqHandlerFixed|IrqHandler|IrqHandlerArray)<codegen::([A-Za-z]+)Holder,.*>::call_irq(<[0-9a-z]+>)?\\(\\)$")
+
+set(errors "")
+set(current "")
+
+# Appends results of the `current` trampoline to the report
+macro(finish_trampoline)
+    if (current)
+        list(GET BUDGET_${ARCH}_${strategy} 0 max_instructions)
+        list(GET BUDGET_${ARCH}_${strategy} 1 max_calls)
+        list(GET BUDGET_${ARCH}_${strategy} 2 max_indirect)
+
+        message(STATUS
+            "${strategy} ${irq}: "
+            "${instructions}/${max_instructions} instructions, "
+            "${calls}/${max_calls} calls, "
+            "${indirect}/${max_indirect} indirect")
+
+        if (instructions GREATER max_instructions OR
+            calls GREATER max_calls OR
+            indirect GREATER max_indirect)
+            list(APPEND errors "${strategy} ${irq} is over budget")
+        endif()
+
+        math(EXPR found_${strategy} "${found_${strategy}} + 1")
+        set(current "")
+    endif()
+endmacro()
+
+foreach(strategy ${STRATEGIES})
+    set(found_${strategy} 0)
+endforeach()
+
+foreach(line IN LISTS lines)
+    if (line MATCHES "^[0-9a-f]+ <(.+)>:$")
+        finish_trampoline()
+
+        set(name "${CMAKE_MATCH_1}")
+        if (name MATCHES "${TRAMPOLINE_REGEX}")
+            set(strategy "${CMAKE_MATCH_2}")
+            set(index "${CMAKE_MATCH_3}")
+            if (NOT DEFINED BUDGET_${ARCH}_${strategy})
+                list(APPEND errors "Unknown strategy `${strategy}`")
+            else()
+                # Array trampolines are told apart by index, not by IRQ
+                if (index)
+                    set(irq "call_irq${index}")
+                else()
+                    string(REGEX MATCH "\\(codegen::Irq\\)[0-9]+" irq "${name}")
+                endif()
+                set(current "${name}")
+                set(instructions 0)
+                set(calls 0)
+                set(indirect 0)
+                set(is_last_jump FALSE)
+            endif()
+        endif()
+    elseif (current AND line MATCHES "^[ \t]+[0-9a-f]+: (R_[A-Z0-9_]+)")
+        # Relocation of the previous instruction: a jump out of
+        # the trampoline, i.e. a tail call
+        if (is_last_jump AND CMAKE_MATCH_1 MATCHES "${CALL_RELOCATION_REGEX}")
+            math(EXPR calls "${calls} + 1")
+        endif()
+        set(is_last_jump FALSE)
+    elseif (current AND line MATCHES "^ *[0-9a-f]+:\t(.*)$")
+        string(STRIP "${CMAKE_MATCH_1}" insn)
+        string(REGEX REPLACE "^((notrack|bnd|rep|repz)[ \t]+)+" "" insn "${insn}")
+
+        # Skip literal pools, alignment and landing pads
+        if (insn STREQUAL "" OR
+            insn MATCHES "^\\." OR
+            insn MATCHES "(^|[ \t])nop" OR
+            insn MATCHES "^endbr")
+            continue()
+        endif()
+
+        if (insn MATCHES "${RETURN_REGEX}")
+            continue()
+        endif()
+
+        math(EXPR instructions "${instructions} + 1")
+
+        set(is_last_jump FALSE)
+
+        if (insn MATCHES "${INDIRECT_REGEX}")
+            math(EXPR indirect "${indirect} + 1")
+        elseif (insn MATCHES "${CALL_REGEX}")
+            math(EXPR calls "${calls} + 1")
+        elseif (insn MATCHES "${JUMP_REGEX}")
+            set(is_last_jump TRUE)
+        endif()
+    endif()
+endforeach()
+
+finish_trampoline()
+
+foreach(strategy ${STRATEGIES})
+    if (NOT found_${strategy} EQUAL EXPECTED_${strategy})
+        list(APPEND errors
+            "Found ${found_${strategy}} trampolines of ${strategy}, expected ${EXPECTED_${strategy}}")
+    endif()
+endforeach()
+
+if (errors)
+    string(REPLACE ";" "\n  " errors "${errors}")
+    message(FATAL_ERROR "Codegen regression (${ARCH}):\n  ${errors}")
+endif()
+
+if (STAMP)
+    file(WRITE ${STAMP} "")
+endif()
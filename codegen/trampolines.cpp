@@ -0,0 +1,172 @@
+/**
+ * @file trampolines.cpp
+ *
+ * Fixed set of IRQ holders used by the codegen regression check.
+ *
+ * Each holder mirrors one of the classes from "examples" folder and is named
+ * after the strategy it exercises: `codegen::<Strategy>Holder`. The
+ * check script finds `call_irq` trampolines by that name and compares
+ * them against per-strategy budgets (see "check_trampolines.cmake").
+ *
+ * Handlers only store a flag so that the trampoline body is as small
+ * as the strategy allows. Do not add any output or logic here, it will
+ * be counted against the budgets.
+ */
+
+#include <cstdint>
+
+#include <ramisr/isr.hpp>
+
+namespace codegen {
+
+enum class Irq : uint8_t
+{
+    DMA = 0,
+    USART1,
+    USART2,
+    USB,
+    ADC1,
+    ADC2,
+    SPI1,
+    TIM1,
+    TIM2,
+    COUNT
+};
+
+/**
+ * @brief Vector table emulation
+ *
+ * Only the trampolines are interesting here, so the table is just
+ * an array and is never used as a real one.
+ */
+ramisr::FreeFunc vectors[uint8_t(Irq::COUNT)];
+
+struct IrqHandlerSetter
+{
+    static void
+    set(ramisr::FreeFunc*, ramisr::FreeFunc func, uint8_t func_shift)
+    {
+        vectors[func_shift] = func;
+    }
+};
+
+using IsrProvider = ramisr::ServiceProvider<0, Irq, IrqHandlerSetter>;
+
+/// Mirrors `examples::IrqHolderFixed`
+class IrqHandlerFixedHolder
+  : IsrProvider::IrqHandlerFixed<IrqHandlerFixedHolder, Irq::USB>
+{
+    friend IsrProvider::PrivateAccessor;
+
+ public:
+    IrqHandlerFixedHolder() : IrqHandlerFixed(this) {}
+
+ private:
+    void call_irq_handler() { _is_usb = true; }
+
+    bool _is_usb = false;
+};
+
+/// Mirrors `examples::IrqHolderFixedWithMultiIrq`
+class MultiIrqHandlerFixedHolder
+  : IsrProvider::
+      MultiIrqHandlerFixed<MultiIrqHandlerFixedHolder, Irq::ADC1, Irq::ADC2>
+{
+    using MultiIrqHandler = IsrProvider::
+      MultiIrqHandlerFixed<MultiIrqHandlerFixedHolder, Irq::ADC1, Irq::ADC2>;
+
+    friend class IsrProvider::PrivateAccessor;
+
+ public:
+    MultiIrqHandlerFixedHolder() : MultiIrqHandler(this) {}
+
+ private:
+    template<Irq>
+    void call_irq_handler();
+
+    bool _is_adc1 = false;
+    bool _is_adc2 = false;
+};
+
+template<>
+void MultiIrqHandlerFixedHolder::call_irq_handler<Irq::ADC1>()
+{
+    _is_adc1 = true;
+}
+
+template<>
+void MultiIrqHandlerFixedHolder::call_irq_handler<Irq::ADC2>()
+{
+    _is_adc2 = true;
+}
+
+/// Mirrors `examples::IrqHolder`
+class IrqHandlerHolder : IsrProvider::IrqHandler<IrqHandlerHolder, Irq::SPI1>
+{
+ public:
+    IrqHandlerHolder() :
+      IsrProvider::IrqHandler<IrqHandlerHolder, Irq::SPI1>(
+        this,
+        &IrqHandlerHolder::_spi1_irq_handler)
+    {
+    }
+
+ private:
+    void _spi1_irq_handler() { _is_spi = true; }
+
+    bool _is_spi = false;
+};
+
+/// Mirrors `examples::MultiIrqHolder`
+class MultiIrqHandlerHolder
+  : public IsrProvider::
+      MultiIrqHandler<MultiIrqHandlerHolder, Irq::USART1, Irq::DMA>
+{
+ public:
+    MultiIrqHandlerHolder() :
+      MultiIrqHandler<MultiIrqHandlerHolder, Irq::USART1, Irq::DMA>(
+        this,
+        &MultiIrqHandlerHolder::_uart1_irq_handler,
+        &MultiIrqHandlerHolder::_dma_irq_handler)
+    {
+    }
+
+ private:
+    void _uart1_irq_handler() { _is_usart = true; }
+    void _dma_irq_handler() { _is_dma = true; }
+
+    bool _is_dma = false;
+    bool _is_usart = false;
+};
+
+/// Mirrors `examples::TimerDriver`
+class IrqHandlerArrayHolder
+{
+    friend IsrProvider::PrivateAccessor;
+
+ private:
+    void call_irq_handler() { _is_update = true; }
+
+    bool _is_update = false;
+};
+
+using IrqHandlerArray =
+  IsrProvider::IrqHandlerArray<IrqHandlerArrayHolder, Irq::TIM1, Irq::TIM2>;
+
+/**
+ * @brief Instantiates all of the trampolines above
+ *
+ * Never called, it only has to be emitted.
+ */
+void register_all()
+{
+    static IrqHandlerFixedHolder irq_handler_fixed_holder;
+    static MultiIrqHandlerFixedHolder multi_irq_handler_fixed_holder;
+    static IrqHandlerHolder irq_handler_holder;
+    static MultiIrqHandlerHolder multi_irq_handler_holder;
+
+    static IrqHandlerArrayHolder irq_handler_array_holders[2];
+    static IrqHandlerArray irq_handler_array(irq_handler_array_holders);
+}
+
+}  // namespace codegen
@@ -0,0 +1,242 @@
+/**
+ * @file idle.cpp
+ *
+ * Host benchmark of ramisr::IdleManager policies.
+ *
+ * An "ADC" thread raises an interrupt every SAMPLE_PERIOD, the handler
+ * posts deferred work for every batch of samples and the main thread
+ * (the emulated core) processes batches and idles in between. The same
+ * load is run with each of sleep modes to compare their wake-to-handler
+ * latency, residency and count of returns to thread code.
+ *
+ * Every run also checks that each raised interrupt is handled, each
+ * posted batch is taken and the core never sleeps while a batch is
+ * pending. Nonzero exit code means a failed check.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+#include <ramisr/idle.hpp>
+#include <ramisr/isr.hpp>
+#include <ramisr/ports/host.hpp>
+
+namespace {
+
+constexpr const auto DURATION = std::chrono::milliseconds(300);
+constexpr const auto SAMPLE_PERIOD = std::chrono::microseconds(100);
+constexpr const uint32_t BATCH = 8;
+
+enum class Irq : uint8_t
+{
+    ADC = 0,
+    COUNT
+};
+
+using Tables = ramisr::port::HostVectorTables<uint8_t(Irq::COUNT)>;
+using IsrProvider = ramisr::ServiceProvider<0, Irq, Tables>;
+
+/// Counts sleeps entered while posted work is pending
+struct Platform : ramisr::port::HostIdlePlatform<Tables>
+{
+    static void wait_for_interrupt()
+    {
+        check_sleep();
+        HostIdlePlatform::wait_for_interrupt();
+    }
+
+    static void wait_for_event()
+    {
+        check_sleep();
+        HostIdlePlatform::wait_for_event();
+    }
+
+    static void check_sleep();
+
+    static inline uint32_t sleeps_with_work = 0;
+};
+
+using Idle = ramisr::IdleManager<IsrProvider, Platform, uint8_t(Irq::COUNT)>;
+
+/// Manager of the current run, checked by Platform
+const Idle* current_idle = nullptr;
+
+void Platform::check_sleep()
+{
+    if (current_idle->select_mode() == Idle::Mode::RUN) {
+        ++sleeps_with_work;
+    }
+}
+
+class AdcHolder : IsrProvider::IrqHandlerFixed<AdcHolder, Irq::ADC>
+{
+    //<! Needed because call_irq_handler is private
+    friend IsrProvider::PrivateAccessor;
+
+ public:
+    AdcHolder(Idle& idle, bool is_armed) :
+      IrqHandlerFixed(this),
+      _idle(idle)
+    {
+        // Samples are always in flight
+        if (is_armed) {
+            _idle.arm();
+        }
+    }
+
+    uint32_t samples() const { return _samples; }
+    uint32_t posted() const { return _posted; }
+
+ private:
+    void call_irq_handler()
+    {
+        Idle::IrqScope scope(_idle, Irq::ADC);
+
+        if (++_samples % BATCH != 0) {
+            return;
+        }
+
+        // Batch is ready, the next one is in flight already
+        ++_posted;
+        _idle.post();
+    }
+
+    Idle& _idle;
+    uint32_t _samples = 0;
+    uint32_t _posted = 0;
+};
+
+const char* mode_name(Idle::Mode mode)
+{
+    switch (mode) {
+        case Idle::Mode::RUN:
+            return "run";
+        case Idle::Mode::WFE:
+            return "wfe";
+        case Idle::Mode::WFI:
+            return "wfi";
+        default:
+            return "sleep-on-exit";
+    }
+}
+
+/// Runs the load with a policy, returns count of failed checks
+uint32_t run(const char* name, bool is_armed, bool is_sleep_on_exit_allowed)
+{
+    Platform::reset();
+    Platform::sleeps_with_work = 0;
+
+    Idle idle;
+    idle.allow_sleep_on_exit(is_sleep_on_exit_allowed);
+    current_idle = &idle;
+
+    AdcHolder adc(idle, is_armed);
+
+    // Two batches at once, so the second one is pending at `idle()`
+    uint32_t raised = 0;
+    for (; raised < 2 * BATCH; ++raised) {
+        Platform::raise(uint8_t(Irq::ADC));
+    }
+
+    std::atomic<bool> is_done{false};
+    std::thread adc_thread([&is_done, &raised] {
+        const auto end = std::chrono::steady_clock::now() + DURATION;
+        auto next = std::chrono::steady_clock::now();
+
+        while (next < end) {
+            next += SAMPLE_PERIOD;
+            std::this_thread::sleep_until(next);
+            Platform::raise(uint8_t(Irq::ADC));
+            ++raised;
+        }
+
+        is_done.store(true);
+        Platform::shutdown();
+    });
+
+    uint32_t batches = 0;
+    uint32_t thread_wakeups = 0;
+    while (!is_done.load()) {
+        // One batch per pass, the manager must not sleep if there are more
+        if (idle.take()) {
+            ++batches;
+        }
+
+        if (idle.idle() != Idle::Mode::RUN) {
+            ++thread_wakeups;
+        }
+    }
+
+    adc_thread.join();
+
+    // Handle interrupts raised before the shutdown and take the rest,
+    // unchecked because batches may be pending here
+    Platform::HostIdlePlatform::wait_for_interrupt();
+    while (idle.take()) {
+        ++batches;
+    }
+
+    const auto statistics = idle.statistics();
+    const auto& adc_statistics = statistics.irqs[uint8_t(Irq::ADC)];
+
+    std::printf("%s\n", name);
+    for (uint8_t mode = 0; mode < uint8_t(Idle::Mode::COUNT); ++mode) {
+        if (statistics.entries[mode] != 0) {
+            std::printf(
+              "  %-14s %8u idle() calls\n", mode_name(Idle::Mode(mode)),
+              statistics.entries[mode]);
+        }
+    }
+    std::printf("  batches:       %8u\n", batches);
+    std::printf("  returns:       %8u to thread code\n", thread_wakeups);
+    std::printf("  wakeups:       %8u by ADC\n", adc_statistics.wakeups);
+    std::printf(
+      "  latency:       %8.1f us average, %.1f us max\n",
+      adc_statistics.wakeups == 0
+        ? 0.0
+        : adc_statistics.latency_sum / 1e3 / adc_statistics.wakeups,
+      adc_statistics.latency_max / 1e3);
+    std::printf(
+      "  residency:     %8.1f %% asleep\n",
+      100.0 * statistics.asleep / statistics.total);
+
+    uint32_t errors = 0;
+    if (adc.samples() != raised) {
+        std::printf(
+          "  FAIL: %u of %u samples handled\n", adc.samples(), raised);
+        ++errors;
+    }
+    if (batches != adc.posted() || adc.posted() != raised / BATCH) {
+        std::printf(
+          "  FAIL: %u of %u posted batches taken\n", batches, adc.posted());
+        ++errors;
+    }
+    if (Platform::sleeps_with_work != 0) {
+        std::printf(
+          "  FAIL: %u sleeps with a pending batch\n",
+          Platform::sleeps_with_work);
+        ++errors;
+    }
+
+    current_idle = nullptr;
+
+    return errors;
+}
+
+}  // namespace
+
+int main()
+{
+    uint32_t errors = 0;
+
+    errors += run("WFE (work armed)", true, true);
+    errors += run("WFI (sleep-on-exit forbidden)", false, false);
+    errors += run("sleep-on-exit", false, true);
+
+    std::printf("errors: %u\n", errors);
+
+    return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,165 @@
+/**
+ * @file seqlock.cpp
+ *
+ * Host torture test and benchmark of ramisr::SeqLock.
+ *
+ * One thread plays an interrupt and writes snapshots as fast as it can,
+ * other threads read them. Every word of a snapshot is derived from its
+ * sequence number, so any torn read is detected. Readers also check that
+ * snapshots never go back in time. Nonzero exit code means a torn read.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include <ramisr/seqlock.hpp>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr const auto DURATION = std::chrono::milliseconds(500);
+
+/// Something like a set of ADC samples with a timestamp
+struct Snapshot
+{
+    uint32_t number;
+    uint16_t samples[12];
+    uint32_t timestamp;
+};
+
+Snapshot make_snapshot(uint32_t number)
+{
+    Snapshot snapshot{};
+    snapshot.number = number;
+    for (size_t i = 0; i < std::size(snapshot.samples); ++i) {
+        snapshot.samples[i] = uint16_t(number * (i + 1));
+    }
+    snapshot.timestamp = ~number;
+
+    return snapshot;
+}
+
+bool is_consistent(const Snapshot& snapshot)
+{
+    const Snapshot expected = make_snapshot(snapshot.number);
+
+    return std::equal(
+             std::begin(snapshot.samples), std::end(snapshot.samples),
+             std::begin(expected.samples)) &&
+           snapshot.timestamp == expected.timestamp;
+}
+
+struct ReaderStats
+{
+    uint64_t reads = 0;
+    uint64_t retries = 0;
+    uint64_t torn = 0;
+    uint64_t reordered = 0;
+};
+
+void reader(
+  const ramisr::SeqLock<Snapshot>& lock,
+  const std::atomic<bool>& is_running,
+  ReaderStats& stats)
+{
+    uint32_t last = 0;
+    Snapshot snapshot;
+
+    while (is_running.load(std::memory_order_relaxed)) {
+        if (!lock.try_read(snapshot)) {
+            ++stats.retries;
+            continue;
+        }
+
+        ++stats.reads;
+
+        if (!is_consistent(snapshot)) {
+            ++stats.torn;
+        }
+
+        if (snapshot.number < last) {
+            ++stats.reordered;
+        }
+        last = snapshot.number;
+    }
+}
+
+/// Runs readers with or without a writer, returns count of errors
+uint64_t run(unsigned readers_count, bool with_writer)
+{
+    ramisr::SeqLock<Snapshot> lock(make_snapshot(0));
+    std::atomic<bool> is_running{true};
+    std::vector<ReaderStats> stats(readers_count);
+
+    std::vector<std::thread> readers;
+    for (auto& reader_stats : stats) {
+        readers.emplace_back(
+          reader, std::cref(lock), std::cref(is_running),
+          std::ref(reader_stats));
+    }
+
+    uint32_t writes = 0;
+    const auto end = Clock::now() + DURATION;
+    if (with_writer) {
+        while (Clock::now() < end) {
+            for (int i = 0; i < 1000; ++i) {
+                lock.write(make_snapshot(++writes));
+            }
+        }
+    }
+    else {
+        std::this_thread::sleep_until(end);
+    }
+
+    is_running.store(false);
+    for (auto& thread : readers) {
+        thread.join();
+    }
+
+    ReaderStats total;
+    for (const auto& reader_stats : stats) {
+        total.reads += reader_stats.reads;
+        total.retries += reader_stats.retries;
+        total.torn += reader_stats.torn;
+        total.reordered += reader_stats.reordered;
+    }
+
+    const double seconds = std::chrono::duration<double>(DURATION).count();
+
+    std::printf(
+      "%u readers, %s writer\n", readers_count, with_writer ? "with" : "no");
+    std::printf("  writes:     %10.2f M/s\n", writes / seconds / 1e6);
+    std::printf("  reads:      %10.2f M/s\n", total.reads / seconds / 1e6);
+    std::printf(
+      "  retries:    %10.2f %%\n",
+      100.0 * total.retries / std::max<uint64_t>(total.reads, 1));
+    std::printf("  torn:       %10llu\n", (unsigned long long)total.torn);
+    std::printf(
+      "  reordered:  %10llu\n", (unsigned long long)total.reordered);
+
+    return total.torn + total.reordered;
+}
+
+}  // namespace
+
+int main()
+{
+    const unsigned readers_count =
+      std::max(2u, std::thread::hardware_concurrency() - 1);
+
+    uint64_t errors = 0;
+
+    errors += run(1, false);
+    errors += run(1, true);
+    errors += run(readers_count, true);
+
+    std::printf("errors: %llu\n", (unsigned long long)errors);
+
+    return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,330 @@
+/**
+ * @file timer_wheel.cpp
+ *
+ * Host benchmark of ramisr::TimerWheel.
+ *
+ * Starts thousands of timers with random delays and measures start,
+ * restart and tick costs in periodic, tickless and deferred modes,
+ * and the worst single tick in periodic mode. Every expiration is
+ * checked against the expected tick, so the benchmark also fails if
+ * some timer is late or early.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <ramisr/timer_wheel.hpp>
+
+#include "../isr_provider.hpp"
+
+namespace {
+
+constexpr const uint32_t MAX_DELAY = 100000;
+
+using Clock = std::chrono::steady_clock;
+
+/// Time source for callbacks, points to a tick counter of a current test
+const uint32_t* current_tick = nullptr;
+
+struct Record
+{
+    uint32_t expected = 0;
+    uint32_t fired = 0;
+    uint32_t errors = 0;
+};
+
+void on_expire(void* context)
+{
+    auto* record = static_cast<Record*>(context);
+
+    if (*current_tick != record->expected) {
+        ++record->errors;
+    }
+
+    ++record->fired;
+}
+
+struct Timers
+{
+    explicit Timers(size_t count) : records(count)
+    {
+        timers.reserve(count);
+        for (auto& record : records) {
+            timers.emplace_back(
+              std::make_unique<ramisr::Timer>(on_expire, &record));
+        }
+    }
+
+    uint32_t errors() const
+    {
+        uint32_t errors = 0;
+        for (const auto& record : records) {
+            errors += record.errors + (record.fired == 1 ? 0 : 1);
+        }
+        return errors;
+    }
+
+    std::vector<Record> records;
+    std::vector<std::unique_ptr<ramisr::Timer>> timers;
+};
+
+double ns_per(Clock::duration duration, size_t count)
+{
+    using Ns = std::chrono::duration<double, std::nano>;
+    return std::chrono::duration_cast<Ns>(duration).count() / double(count);
+}
+
+/// Starts all of timers, then restarts a half of them
+template<class Wheel>
+void start_all(
+  Wheel& wheel,
+  Timers& timers,
+  std::mt19937& random,
+  uint32_t now)
+{
+    std::uniform_int_distribution<uint32_t> delays(1, MAX_DELAY);
+    const size_t count = timers.timers.size();
+
+    auto begin = Clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t delay = delays(random);
+        timers.records[i].expected = now + delay;
+        wheel.start(*timers.timers[i], delay);
+    }
+    auto end = Clock::now();
+
+    std::printf("  start:      %7.1f ns/timer\n", ns_per(end - begin, count));
+
+    begin = Clock::now();
+    for (size_t i = 0; i < count; i += 2) {
+        const uint32_t delay = delays(random);
+        timers.records[i].expected = now + delay;
+        wheel.stop(*timers.timers[i]);
+        wheel.start(*timers.timers[i], delay);
+    }
+    end = Clock::now();
+
+    std::printf(
+      "  restart:    %7.1f ns/timer\n", ns_per(end - begin, count / 2));
+}
+
+uint32_t bench_periodic(size_t count)
+{
+    std::printf("periodic, %zu timers\n", count);
+
+    static ramisr::TimerWheel<> wheel;
+    uint32_t tick = wheel.now();
+    current_tick = &tick;
+
+    Timers timers(count);
+    std::mt19937 random(1);
+    start_all(wheel, timers, random, tick);
+
+    // Every tick is timed, the worst one includes cascades and
+    // is what an interrupt budget needs
+    Clock::duration total{};
+    Clock::duration worst{};
+    for (uint32_t i = 0; i < MAX_DELAY; ++i) {
+        ++tick;
+
+        const auto begin = Clock::now();
+        wheel.tick();
+        const auto duration = Clock::now() - begin;
+
+        total += duration;
+        worst = std::max(worst, duration);
+    }
+
+    std::printf("  tick:       %7.1f ns/tick\n", ns_per(total, MAX_DELAY));
+    std::printf("  worst tick: %7.1f us\n", ns_per(worst, 1) / 1e3);
+
+    return timers.errors();
+}
+
+uint32_t bench_tickless(size_t count)
+{
+    std::printf("tickless, %zu timers\n", count);
+
+    static ramisr::TimerWheel<> wheel;
+    uint32_t tick = wheel.now();
+    current_tick = &tick;
+
+    Timers timers(count);
+    std::mt19937 random(2);
+    start_all(wheel, timers, random, tick);
+
+    size_t wakeups = 0;
+    const auto begin = Clock::now();
+    for (uint32_t next = wheel.ticks_to_next_event();
+         next != ramisr::TimerWheel<>::NO_EVENT;
+         next = wheel.ticks_to_next_event()) {
+        tick += next;
+        wheel.advance(next);
+        ++wakeups;
+    }
+    const auto end = Clock::now();
+
+    std::printf("  wakeups:    %7zu\n", wakeups);
+    std::printf("  wakeup:     %7.1f ns\n", ns_per(end - begin, wakeups));
+
+    return timers.errors();
+}
+
+uint32_t bench_deferred(size_t count)
+{
+    std::printf("deferred, %zu timers\n", count);
+
+    using Wheel = ramisr::TimerWheel<5, 5, true>;
+
+    static Wheel wheel;
+    uint32_t tick = wheel.now();
+    current_tick = &tick;
+
+    Timers timers(count);
+    std::mt19937 random(3);
+    start_all(wheel, timers, random, tick);
+
+    size_t called = 0;
+    const auto begin = Clock::now();
+    for (uint32_t i = 0; i < MAX_DELAY; ++i) {
+        ++tick;
+        wheel.tick();
+        called += wheel.run_deferred();
+    }
+    const auto end = Clock::now();
+
+    std::printf(
+      "  tick + run: %7.1f ns/tick\n", ns_per(end - begin, MAX_DELAY));
+    std::printf("  called:     %7zu\n", called);
+
+    return timers.errors();
+}
+
+/**
+ * @brief Emulation of a programmable tick timer
+ *
+ * Time is jumped straight to the programmed interrupt.
+ */
+struct EmulatedTicklessSource
+{
+    static constexpr const bool IS_TICKLESS = true;
+    static constexpr const uint32_t MAX_TICKS = 0xFFFFFF / 72;
+
+    static void program(uint32_t ticks)
+    {
+        programmed = ticks;
+        elapsed_ticks = 0;
+    }
+
+    static uint32_t elapsed() { return elapsed_ticks; }
+
+    static inline uint32_t programmed = 0;
+    static inline uint32_t elapsed_ticks = 0;
+};
+
+/// Timer restarting itself from its callback
+struct Periodic
+{
+    static constexpr const uint32_t PERIOD = 10;
+    static constexpr const uint32_t RESTARTS = 1000;
+
+    Record record;
+    uint32_t restarts = 0;
+    ramisr::Timer* timer = nullptr;
+};
+
+/// Starts timers from "thread" between programmed interrupts
+/// and restarts a periodic one from the interrupt
+uint32_t bench_tickless_holder(size_t count)
+{
+    std::printf("tickless holder, %zu timers\n", count);
+
+    using Source = EmulatedTicklessSource;
+    using Holder = ramisr::TimerWheelHolder<
+      examples::IsrProvider,
+      examples::IsrProvider::Irq::SYS_TICK,
+      ramisr::TimerWheel<>,
+      Source>;
+
+    static Holder holder;
+    uint32_t tick = 0;
+    current_tick = &tick;
+
+    Timers timers(count);
+    std::mt19937 random(4);
+    std::uniform_int_distribution<uint32_t> delays(1, MAX_DELAY);
+    std::uniform_int_distribution<uint32_t> gaps(0, 20);
+
+    Periodic periodic;
+    ramisr::Timer periodic_timer(
+      [](void* context) {
+          auto* periodic = static_cast<Periodic*>(context);
+          on_expire(&periodic->record);
+
+          if (++periodic->restarts < Periodic::RESTARTS) {
+              periodic->record.expected = *current_tick + Periodic::PERIOD;
+              holder.start(*periodic->timer, Periodic::PERIOD);
+          }
+      },
+      &periodic);
+    periodic.timer = &periodic_timer;
+
+    periodic.record.expected = tick + Periodic::PERIOD;
+    holder.start(periodic_timer, Periodic::PERIOD);
+
+    size_t started = 0;
+    size_t wakeups = 0;
+    const auto begin = Clock::now();
+    while (started < count || Source::programmed < Source::MAX_TICKS) {
+        const uint32_t to_irq = Source::programmed - Source::elapsed_ticks;
+        const uint32_t gap = started < count ? gaps(random) : to_irq;
+
+        if (gap < to_irq) {
+            tick += gap;
+            Source::elapsed_ticks += gap;
+
+            const uint32_t delay = delays(random);
+            timers.records[started].expected = tick + delay;
+            holder.start(*timers.timers[started], delay);
+            ++started;
+        }
+        else {
+            tick += to_irq;
+            Source::elapsed_ticks += to_irq;
+
+            global_irq_vectors.sys_tick_irq();
+            ++wakeups;
+        }
+    }
+    const auto end = Clock::now();
+
+    std::printf("  wakeups:    %7zu\n", wakeups);
+    std::printf(
+      "  total:      %7.1f ns/timer\n", ns_per(end - begin, count));
+
+    return timers.errors() + periodic.record.errors +
+           (periodic.record.fired == Periodic::RESTARTS ? 0 : 1);
+}
+
+}  // namespace
+
+int main()
+{
+    uint32_t errors = 0;
+
+    for (size_t count : {10000, 100000}) {
+        errors += bench_periodic(count);
+        errors += bench_tickless(count);
+        errors += bench_deferred(count);
+        errors += bench_tickless_holder(count);
+    }
+
+    std::printf("errors: %u\n", errors);
+
+    return errors == 0 ? 0 : 1;
+}
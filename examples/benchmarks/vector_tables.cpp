@@ -0,0 +1,187 @@
+/**
+ * @file vector_tables.cpp
+ *
+ * Host test and benchmark of switching vector tables of two
+ * ServiceProvider specializations (see HostVectorTables).
+ *
+ * Checks that after `activate_vector_table` every raised interrupt is
+ * handled by a holder of the active set only and that `raise` returns
+ * false for a vector without a handler in the active table. Then
+ * measures a cost of a switch plus an interrupt. Nonzero exit code
+ * means a failed check.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+#include <ramisr/isr.hpp>
+#include <ramisr/ports/host.hpp>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr const uint32_t SWITCHES = 1000000;
+
+enum class Irq : uint8_t
+{
+    ADC = 0,
+    DMA,
+    TIM,  //<! has no handler in both of tables
+    COUNT
+};
+
+using Tables = ramisr::port::HostVectorTables<uint8_t(Irq::COUNT), 2>;
+using IdleMode = ramisr::ServiceProvider<0, Irq, Tables>;
+using StreamingMode = ramisr::ServiceProvider<1, Irq, Tables>;
+
+enum class Set : uint8_t
+{
+    NONE = 0,
+    IDLE,
+    STREAMING
+};
+
+/// The last called handler
+struct Call
+{
+    Set set = Set::NONE;
+    Irq irq = Irq::COUNT;
+};
+
+Call last_call;
+
+class IdleAdcHolder : IdleMode::IrqHandlerFixed<IdleAdcHolder, Irq::ADC>
+{
+    //<! Needed because call_irq_handler is private
+    friend IdleMode::PrivateAccessor;
+
+ public:
+    IdleAdcHolder() : IrqHandlerFixed(this) {}
+
+    uint32_t calls() const { return _calls; }
+
+ private:
+    void call_irq_handler()
+    {
+        last_call = {Set::IDLE, Irq::ADC};
+        ++_calls;
+    }
+
+    uint32_t _calls = 0;
+};
+
+class StreamingHolder
+  : StreamingMode::
+      MultiIrqHandlerFixed<StreamingHolder, Irq::ADC, Irq::DMA>
+{
+    using MultiIrqHandler = StreamingMode::
+      MultiIrqHandlerFixed<StreamingHolder, Irq::ADC, Irq::DMA>;
+
+    //<! Needed because call_irq_handler is private
+    friend StreamingMode::PrivateAccessor;
+
+ public:
+    StreamingHolder() : MultiIrqHandler(this) {}
+
+    uint32_t calls() const { return _calls; }
+
+ private:
+    template<Irq IRQ>
+    void call_irq_handler()
+    {
+        last_call = {Set::STREAMING, IRQ};
+        ++_calls;
+    }
+
+    uint32_t _calls = 0;
+};
+
+/// Raises an interrupt and checks which handler was called
+uint32_t check_raise(Irq irq, Set expected_set, const char* name)
+{
+    last_call = {};
+
+    const bool is_handled = Tables::raise(uint8_t(irq));
+    const bool is_expected_handled = expected_set != Set::NONE;
+
+    const bool is_ok = is_handled == is_expected_handled &&
+                       last_call.set == expected_set &&
+                       (!is_handled || last_call.irq == irq);
+
+    std::printf("  %-26s %s\n", name, is_ok ? "ok" : "FAIL");
+
+    return is_ok ? 0 : 1;
+}
+
+uint32_t test_switch()
+{
+    std::printf("switch\n");
+
+    uint32_t errors = 0;
+
+    IdleMode::activate_vector_table();
+    errors += check_raise(Irq::ADC, Set::IDLE, "idle: ADC");
+    errors += check_raise(Irq::DMA, Set::NONE, "idle: no DMA handler");
+    errors += check_raise(Irq::TIM, Set::NONE, "idle: no TIM handler");
+
+    StreamingMode::activate_vector_table();
+    errors += check_raise(Irq::ADC, Set::STREAMING, "streaming: ADC");
+    errors += check_raise(Irq::DMA, Set::STREAMING, "streaming: DMA");
+    errors += check_raise(Irq::TIM, Set::NONE, "streaming: no TIM handler");
+
+    IdleMode::activate_vector_table();
+    errors += check_raise(Irq::ADC, Set::IDLE, "idle again: ADC");
+
+    return errors;
+}
+
+uint32_t bench_switch(
+  const IdleAdcHolder& idle,
+  const StreamingHolder& streaming)
+{
+    std::printf("switch + raise, %u times\n", SWITCHES);
+
+    const uint32_t idle_calls = idle.calls();
+    const uint32_t streaming_calls = streaming.calls();
+
+    const auto begin = Clock::now();
+    for (uint32_t i = 0; i < SWITCHES; i += 2) {
+        StreamingMode::activate_vector_table();
+        Tables::raise(uint8_t(Irq::ADC));
+
+        IdleMode::activate_vector_table();
+        Tables::raise(uint8_t(Irq::ADC));
+    }
+    const auto end = Clock::now();
+
+    using Ns = std::chrono::duration<double, std::nano>;
+    std::printf(
+      "  cost:       %7.1f ns\n",
+      std::chrono::duration_cast<Ns>(end - begin).count() / SWITCHES);
+
+    const bool is_ok = idle.calls() - idle_calls == SWITCHES / 2 &&
+                       streaming.calls() - streaming_calls == SWITCHES / 2;
+
+    std::printf("  calls:      %7s\n", is_ok ? "ok" : "FAIL");
+
+    return is_ok ? 0 : 1;
+}
+
+}  // namespace
+
+int main()
+{
+    IdleAdcHolder idle;
+    StreamingHolder streaming;
+
+    uint32_t errors = 0;
+
+    errors += test_switch();
+    errors += bench_switch(idle, streaming);
+
+    std::printf("errors: %u\n", errors);
+
+    return errors == 0 ? 0 : 1;
+}
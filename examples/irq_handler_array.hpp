@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+
+#include "config.hpp"
+#include "isr_provider.hpp"
+
+namespace examples {
+
+/**
+ * @brief Driver of one of identical timer peripherals
+ */
+class TimerDriver
+{
+    //<! Needed because call_irq_handler is private
+    friend IsrProvider::PrivateAccessor;
+
+ public:
+    TimerDriver(uint8_t number) : _number(number) {}
+
+ private:
+    void call_irq_handler()
+    {
+        if constexpr (config::examples::IS_PRINT_ENABLED) {
+            std::cout << "TIM" << int(_number) << " interrupt!"
+                      << "\n";
+        }
+
+        _is_update = true;
+    }
+
+    uint8_t _number;
+    bool _is_update = false;
+};
+
+/**
+ * @brief Binds I-th timer driver to I-th timer interrupt
+ */
+using TimerIrqs = IsrProvider::IrqHandlerArray<
+  TimerDriver,
+  IsrProvider::Irq::TIM1,
+  IsrProvider::Irq::TIM2,
+  IsrProvider::Irq::TIM3>;
+
+}  // namespace examples
@@ -3,11 +3,16 @@
 #include "irq_holder.hpp"
 #include "multi_irq_holder.hpp"
 
+#include "irq_handler_array.hpp"
 #include "irq_holder_fixed.hpp"
 #include "multi_irq_holder_fixed.hpp"
 
 #include "irq_singleton_holder.hpp"
 
+#include "timer_wheel_holder.hpp"
+
+#include "vector_tables.hpp"
+
 int main()
 {
     // IrqHandler examples
@@ -18,9 +23,22 @@ int main()
     examples::IrqHolderFixed irq_holder_fixed;
     examples::IrqHolderFixedWithMultiIrq irq_holder_fixed_with_multi_irq;
 
+    // IrqHandlerArray example
+    examples::TimerDriver timers[] = {1, 2, 3};
+    examples::TimerIrqs timer_irqs(timers);
+
     // Free function registration example
     auto& irq_holder_singleton = examples::IrqHolderSingleton::instance();
 
+    // Software timers example
+    static examples::SysTickTimers sys_tick_timers;
+    examples::TimeoutHolder timeout_holder(sys_tick_timers);
+    timeout_holder.start(2);
+
+    // Vector tables per operating mode example
+    examples::IdleAdcHolder idle_adc_holder;
+    examples::StreamingHolder streaming_holder;
+
     // Simulate interrupt
     global_irq_vectors.usart1_irq();
     global_irq_vectors.dma_irq();
@@ -29,6 +47,20 @@ int main()
     global_irq_vectors.adc1_irq();
     global_irq_vectors.adc2_irq();
     global_irq_vectors.spi1_irq();
+    global_irq_vectors.sys_tick_irq();
+    global_irq_vectors.sys_tick_irq();
+    global_irq_vectors.tim1_irq();
+    global_irq_vectors.tim2_irq();
+    global_irq_vectors.tim3_irq();
+
+    // Simulate interrupts in both modes
+    examples::IdleMode::activate_vector_table();
+    examples::ModeTables::raise(Irq::ADC1);
+    examples::ModeTables::raise(Irq::DMA);
+
+    examples::StreamingMode::activate_vector_table();
+    examples::ModeTables::raise(Irq::ADC1);
+    examples::ModeTables::raise(Irq::DMA);
 
     return 0;
 }
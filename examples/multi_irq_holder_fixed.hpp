@@ -3,11 +3,22 @@
 #include <cstdint>
 #include <iostream>
 
+#include <ramisr/seqlock.hpp>
+
 #include "config.hpp"
 #include "isr_provider.hpp"
 
 namespace examples {
 
+/**
+ * @brief Multiword state shared by an ADC IRQ with thread code
+ */
+struct AdcSnapshot
+{
+    uint16_t result = 0;
+    uint32_t conversions = 0;
+};
+
 class IrqHolderFixedWithMultiIrq
   : IsrProvider::MultiIrqHandlerFixed<
       IrqHolderFixedWithMultiIrq,
@@ -25,6 +36,16 @@ class IrqHolderFixedWithMultiIrq
  public:
     IrqHolderFixedWithMultiIrq() : MultiIrqHandler(this) {}
 
+    /**
+     * @brief Last ADC1 result, safe to call from thread code
+     */
+    AdcSnapshot adc1() const { return _adc1.read(); }
+
+    /**
+     * @brief Last ADC2 result, safe to call from thread code
+     */
+    AdcSnapshot adc2() const { return _adc2.read(); }
+
  private:
     /**
      * @brief Tempalate handler for all IRQs
@@ -39,6 +60,13 @@ class IrqHolderFixedWithMultiIrq
 
     bool _is_adc1 = false;
     bool _is_adc2 = false;
+
+    // SeqLock allows only one writer, so each IRQ has its own one:
+    // IRQs of different priorities may preempt each other
+    AdcSnapshot _last_adc1;  //<! Owned by ADC1 IRQ
+    AdcSnapshot _last_adc2;  //<! Owned by ADC2 IRQ
+    ramisr::SeqLock<AdcSnapshot> _adc1;
+    ramisr::SeqLock<AdcSnapshot> _adc2;
 };
 
 /**
@@ -53,6 +81,10 @@ void IrqHolderFixedWithMultiIrq::call_irq_handler<IsrProvider::Irq::ADC1>()
     }
 
     _is_adc1 = true;
+
+    _last_adc1.result = 0x123;  // stub of a conversion result
+    ++_last_adc1.conversions;
+    _adc1.write(_last_adc1);
 }
 
 /**
@@ -67,6 +99,10 @@ void IrqHolderFixedWithMultiIrq::call_irq_handler<IsrProvider::Irq::ADC2>()
     }
 
     _is_adc2 = true;
+
+    _last_adc2.result = 0x456;  // stub of a conversion result
+    ++_last_adc2.conversions;
+    _adc2.write(_last_adc2);
 }
 
 }  // namespace examples
\ No newline at end of file
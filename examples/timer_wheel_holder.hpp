@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+
+#include <ramisr/timer_wheel.hpp>
+
+#include "config.hpp"
+#include "isr_provider.hpp"
+
+namespace examples {
+
+/**
+ * @brief Software timers driven by SysTick interrupt
+ */
+using SysTickTimers =
+  ramisr::TimerWheelHolder<IsrProvider, IsrProvider::Irq::SYS_TICK>;
+
+class TimeoutHolder
+{
+ public:
+    TimeoutHolder(SysTickTimers& timers) : _timers(timers) {}
+
+    void start(uint32_t ticks) { _timers.start(_timeout, ticks); }
+
+ private:
+    static void _on_timeout(void* context)
+    {
+        if constexpr (config::examples::IS_PRINT_ENABLED) {
+            std::cout << "Timeout!"
+                      << "\n";
+        }
+
+        static_cast<TimeoutHolder*>(context)->_is_timeout = true;
+    }
+
+    SysTickTimers& _timers;
+    ramisr::Timer _timeout{&TimeoutHolder::_on_timeout, this};
+
+    bool _is_timeout = false;
+};
+
+}  // namespace examples
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+
+#include <ramisr/ports/host.hpp>
+
+#include "config.hpp"
+#include "vectors/vectors.h"
+
+namespace examples {
+
+/**
+ * @brief Two emulated RAM vector tables, one per operating mode
+ */
+using ModeTables = ramisr::port::HostVectorTables<16, 2>;
+
+using IdleMode = ramisr::ServiceProvider<0, Irq, ModeTables>;
+using StreamingMode = ramisr::ServiceProvider<1, Irq, ModeTables>;
+
+/**
+ * @brief ADC handler of low-power idle mode
+ */
+class IdleAdcHolder : IdleMode::IrqHandlerFixed<IdleAdcHolder, Irq::ADC1>
+{
+    //<! Needed because call_irq_handler is private
+    friend IdleMode::PrivateAccessor;
+
+ public:
+    IdleAdcHolder() : IrqHandlerFixed(this) {}
+
+ private:
+    void call_irq_handler()
+    {
+        if constexpr (config::examples::IS_PRINT_ENABLED) {
+            std::cout << "Idle mode: ADC1 interrupt!"
+                      << "\n";
+        }
+
+        _is_adc = true;
+    }
+
+    bool _is_adc = false;
+};
+
+/**
+ * @brief ADC and DMA handlers of high-throughput streaming mode
+ */
+class StreamingHolder
+  : StreamingMode::
+      MultiIrqHandlerFixed<StreamingHolder, Irq::ADC1, Irq::DMA>
+{
+    using MultiIrqHandler = StreamingMode::
+      MultiIrqHandlerFixed<StreamingHolder, Irq::ADC1, Irq::DMA>;
+
+    //<! Needed because call_irq_handler is private
+    friend StreamingMode::PrivateAccessor;
+
+ public:
+    StreamingHolder() : MultiIrqHandler(this) {}
+
+ private:
+    template<Irq IRQ>
+    void call_irq_handler()
+    {
+        if constexpr (config::examples::IS_PRINT_ENABLED) {
+            std::cout << "Streaming mode: "
+                      << (IRQ == Irq::DMA ? "DMA" : "ADC1") << " interrupt!"
+                      << "\n";
+        }
+
+        ++_irq_count;
+    }
+
+    uint32_t _irq_count = 0;
+};
+
+}  // namespace examples
@@ -11,6 +11,10 @@ struct Vectors
     void (*adc1_irq)();
     void (*adc2_irq)();
     void (*spi1_irq)();
+    void (*sys_tick_irq)();
+    void (*tim1_irq)();
+    void (*tim2_irq)();
+    void (*tim3_irq)();
 };
 
 extern struct Vectors global_irq_vectors;
@@ -23,6 +27,10 @@ enum Irq
     USB,
     ADC1,
     ADC2,
-    SPI1
+    SPI1,
+    SYS_TICK,
+    TIM1,
+    TIM2,
+    TIM3
     // others
 };
\ No newline at end of file
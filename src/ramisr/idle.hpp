@@ -0,0 +1,336 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace ramisr {
+
+/**
+ * @brief Idle manager choosing a sleep mode by pending deferred work
+ *
+ * Thread code calls `idle()` whenever it has nothing to do. Interrupt
+ * handlers report deferred work with `post()` and work which is in
+ * flight (e.g. a started transfer whose completion will post work)
+ * with `arm()`/`disarm()`. The mode is picked as:
+ *
+ *  - RUN: posted work is pending, don't sleep;
+ *  - WFE: some work is armed, it will come soon and `post()` sends
+ *    an event, so WFE can't miss it;
+ *  - SLEEP_ON_EXIT: nothing is armed and it is allowed, the core
+ *    sleeps right after each handler without returning to thread
+ *    code until some handler posts work;
+ *  - WFI: nothing is armed, checked with interrupts masked.
+ *
+ * Handlers of ServiceProvider holders report their entry and exit
+ * with IrqScope, which also records wake-to-handler latency and
+ * sleep residency using the Platform clock:
+ *
+ * @code{.cpp}
+ *
+ * using Idle = ramisr::IdleManager<IsrProvider, Platform, 64>;
+ * Idle idle;
+ *
+ * void AdcHolder::call_irq_handler()
+ * {
+ *     Idle::IrqScope scope(idle, IsrProvider::Irq::ADC1);
+ *     // ...
+ *     idle.post();
+ * }
+ *
+ * // thread code
+ * while (true) {
+ *     if (idle.take()) {
+ *         process_adc();
+ *     }
+ *     else {
+ *         idle.idle();
+ *     }
+ * }
+ *
+ * @endcode
+ *
+ * Platform must provide:
+ *
+ * @code{.cpp}
+ *
+ * struct Platform
+ * {
+ *     using Time = uint32_t;       // unsigned, wraps around
+ *     static Time now();
+ *     static Time wake_time();     // when the core was woken up
+ *     static void disable_irq();   // PRIMASK
+ *     static void enable_irq();
+ *     static void wait_for_interrupt();
+ *     static void wait_for_event();
+ *     static void send_event();
+ *     static void set_sleep_on_exit(bool is_enabled);
+ * };
+ *
+ * @endcode
+ *
+ * See `port::HostIdlePlatform` for an emulation on a host.
+ *
+ * @tparam IsrProvider - ServiceProvider specialization
+ * @tparam Platform - sleep instructions and clock
+ * @tparam IRQ_COUNT - count of IRQs to collect statistics for
+ */
+template<class IsrProvider, class Platform, size_t IRQ_COUNT>
+class IdleManager
+{
+    using Irq = typename IsrProvider::Irq;
+    using Time = typename Platform::Time;
+
+ public:
+    enum class Mode : uint8_t
+    {
+        RUN = 0,
+        WFE,
+        WFI,
+        SLEEP_ON_EXIT,
+        COUNT
+    };
+
+    struct IrqStatistics
+    {
+        uint32_t wakeups = 0;  //<! times the IRQ woke the core up
+        uint64_t latency_sum = 0;
+        Time latency_max = 0;
+    };
+
+    struct Statistics
+    {
+        uint64_t asleep = 0;  //<! time spent sleeping
+        uint64_t total = 0;   //<! time since reset of statistics
+        uint32_t entries[size_t(Mode::COUNT)] = {};  //<! `idle()` per mode
+        IrqStatistics irqs[IRQ_COUNT] = {};
+    };
+
+    /**
+     * @brief Reports entry and exit of an interrupt handler
+     */
+    class IrqScope
+    {
+     public:
+        IrqScope(IdleManager& manager, Irq irq) : _manager(manager)
+        {
+            _manager.on_irq_entry(irq);
+        }
+
+        ~IrqScope() { _manager.on_irq_exit(); }
+
+        IrqScope(const IrqScope&) = delete;
+        IrqScope& operator=(const IrqScope&) = delete;
+        IrqScope(IrqScope&&) = delete;
+        IrqScope& operator=(IrqScope&&) = delete;
+
+     private:
+        IdleManager& _manager;
+    };
+
+    IdleManager() : _statistics_started(Platform::now()) {}
+
+    IdleManager(const IdleManager&) = delete;
+    IdleManager& operator=(const IdleManager&) = delete;
+    IdleManager(IdleManager&&) = delete;
+    IdleManager& operator=(IdleManager&&) = delete;
+
+    /**
+     * @brief Allow or forbid SLEEP_ON_EXIT mode (allowed by default)
+     */
+    void allow_sleep_on_exit(bool is_allowed)
+    {
+        _is_sleep_on_exit_allowed = is_allowed;
+    }
+
+    /**
+     * @brief Report a ready deferred work item (from an interrupt)
+     */
+    void post()
+    {
+        _pending.fetch_add(1, std::memory_order_release);
+
+        if (_is_sleeping_on_exit) {
+            _is_sleeping_on_exit = false;
+            Platform::set_sleep_on_exit(false);
+        }
+
+        Platform::send_event();
+    }
+
+    /**
+     * @brief Take one posted work item (from thread code)
+     *
+     * @return false if there is nothing to do
+     */
+    bool take()
+    {
+        uint32_t pending = _pending.load(std::memory_order_acquire);
+
+        while (pending != 0) {
+            if (_pending.compare_exchange_weak(
+                  pending, pending - 1, std::memory_order_acquire)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Report work in flight which will be posted later
+     */
+    void arm() { _armed.fetch_add(1, std::memory_order_relaxed); }
+
+    /**
+     * @brief Report that armed work is posted or cancelled
+     */
+    void disarm() { _armed.fetch_sub(1, std::memory_order_relaxed); }
+
+    /**
+     * @brief Mode `idle()` would use now
+     */
+    Mode select_mode() const
+    {
+        if (_pending.load(std::memory_order_acquire) != 0) {
+            return Mode::RUN;
+        }
+
+        if (_armed.load(std::memory_order_relaxed) != 0) {
+            return Mode::WFE;
+        }
+
+        return _is_sleep_on_exit_allowed ? Mode::SLEEP_ON_EXIT : Mode::WFI;
+    }
+
+    /**
+     * @brief Sleep until there is something to do (from thread code)
+     *
+     * @return used mode
+     */
+    Mode idle()
+    {
+        Platform::disable_irq();
+
+        const Mode mode = select_mode();
+        ++_statistics.entries[size_t(mode)];
+
+        if (mode == Mode::RUN) {
+            Platform::enable_irq();
+            return mode;
+        }
+
+        _sleep_started = Platform::now();
+        _is_asleep = true;
+
+        switch (mode) {
+            case Mode::WFE:
+                // A post between the check and WFE leaves an event
+                Platform::enable_irq();
+                Platform::wait_for_event();
+                break;
+
+            case Mode::SLEEP_ON_EXIT:
+                _is_sleeping_on_exit = true;
+                Platform::set_sleep_on_exit(true);
+                Platform::wait_for_interrupt();
+                Platform::enable_irq();
+                break;
+
+            default:
+                // Masked interrupt still wakes the core up
+                Platform::wait_for_interrupt();
+                Platform::enable_irq();
+                break;
+        }
+
+        // Woken up without a handler (e.g. by an event). Masked, else
+        // a handler may count the same sleep between check and clear
+        Platform::disable_irq();
+        if (_is_asleep) {
+            _is_asleep = false;
+            _statistics.asleep += Time(Platform::now() - _sleep_started);
+        }
+        Platform::enable_irq();
+
+        return mode;
+    }
+
+    /**
+     * @brief Statistics since creation or the last reset
+     *
+     * Copied with interrupts masked (call it from thread code):
+     * handlers update 64-bit fields, which are not written
+     * atomically on a 32-bit core.
+     */
+    Statistics statistics() const
+    {
+        Platform::disable_irq();
+        Statistics statistics = _statistics;
+        statistics.total = Time(Platform::now() - _statistics_started);
+        Platform::enable_irq();
+
+        return statistics;
+    }
+
+    void reset_statistics()
+    {
+        Platform::disable_irq();
+        _statistics = Statistics{};
+        _statistics_started = Platform::now();
+        Platform::enable_irq();
+    }
+
+ private:
+    void on_irq_entry(Irq irq)
+    {
+        if (!_is_asleep) {
+            return;
+        }
+
+        const Time entered = Platform::now();
+        const Time woken = Platform::wake_time();
+        const Time latency = Time(entered - woken);
+
+        // Woken up by an interrupt pended before the sleep
+        const Time slept = Time(woken - _sleep_started) >
+                               Time(entered - _sleep_started)
+                             ? Time(0)
+                             : Time(woken - _sleep_started);
+
+        _is_asleep = false;
+        _statistics.asleep += slept;
+
+        if (size_t(irq) < IRQ_COUNT) {
+            auto& irq_statistics = _statistics.irqs[size_t(irq)];
+
+            ++irq_statistics.wakeups;
+            irq_statistics.latency_sum += latency;
+            if (latency > irq_statistics.latency_max) {
+                irq_statistics.latency_max = latency;
+            }
+        }
+    }
+
+    void on_irq_exit()
+    {
+        // The core goes back to sleep right after the handler
+        if (_is_sleeping_on_exit) {
+            _sleep_started = Platform::now();
+            _is_asleep = true;
+        }
+    }
+
+    std::atomic<uint32_t> _pending{0};
+    std::atomic<uint32_t> _armed{0};
+
+    bool _is_sleep_on_exit_allowed = true;
+    volatile bool _is_sleeping_on_exit = false;
+    volatile bool _is_asleep = false;
+
+    Time _sleep_started = 0;
+    Time _statistics_started = 0;
+    Statistics _statistics;
+};
+
+}  // namespace ramisr
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <type_traits>
+#include <utility>
 
 namespace ramisr {
 
@@ -47,10 +50,31 @@ struct DeafultRamIrqHandlerSetter
  * `move_vector_table_to_ram` from one of the ports files
  * to move your vector table to RAM.
  *
+ * Several ServiceProvider specializations with different addresses
+ * may be used as prepared handler sets (e.g. per operating mode).
+ * Copy the vector table to each of them (`copy_vector_table_to_ram`),
+ * register holders of each set ahead of time and switch the whole
+ * set at once with `activate_vector_table`. It needs IrqHandlerSetter
+ * with `activate`, e.g. `RamIrqHandlerSetter` from a ports file:
+ *
+ * @code{.cpp}
+ *
+ * using Setter = irq::port::RamIrqHandlerSetter;
+ * using IdleMode = ramisr::ServiceProvider<0x2001F800, Irq, Setter>;
+ * using StreamingMode = ramisr::ServiceProvider<0x2001FC00, Irq, Setter>;
+ *
+ * // ... register holders of both modes
+ *
+ * StreamingMode::activate_vector_table();
+ *
+ * @endcode
+ *
  * @tparam VECTOR_TABLE_ADDRESS - start address of vector table in RAM
  * @tparam VectorTableEnum - enum describing a vector table structure
  * @tparam IrqHandlerSetter - special behaviour of setting Irq handler
  *         (by default it is just an assign, see DeafultRamIrqHandlerSetter)
+ *         and of activation of a vector table (`activate`, needed
+ *         only if `activate_vector_table` is used)
  */
 template<
   uint32_t VECTOR_TABLE_ADDRESS,
@@ -77,6 +101,22 @@ struct ServiceProvider
         IrqHandlerSetter::set(vectors_table_start, func, uint8_t(irq));
     }
 
+    /**
+     * @brief Make this vector table active
+     *
+     * Switches all of interrupts to handlers registered through this
+     * ServiceProvider with `IrqHandlerSetter::activate`. On Cortex-M it
+     * is one VTOR store plus barriers, so there is no moment with a mix
+     * of two handler sets.
+     *
+     * @note Table address must be aligned as VTOR requires
+     *       (to a power of two not less than the table size).
+     */
+    static inline void activate_vector_table()
+    {
+        IrqHandlerSetter::activate(VECTOR_TABLE_START_ADDR);
+    }
+
     struct PrivateAccessor
     {
         template<
@@ -277,6 +317,83 @@ struct ServiceProvider
         MultiIrqHandler(MultiIrqHandler&&) = delete;
         MultiIrqHandler& operator=(MultiIrqHandler&&) = delete;
     };
+
+    /**
+     * @brief Register an array of identical drivers, one per interrupt
+     *
+     * I-th interrupt from IRQS calls `call_irq_handler` method of
+     * I-th driver instance. Every interrupt gets its own trampoline
+     * with the index known at compile time, so there are no runtime
+     * lookups and it is as fast as IrqHandlerFixed.
+     *
+     * Like IrqHandlerFixed, it requires the PrivateAccessor
+     * to be a friend of Driver if `call_irq_handler` is private.
+     *
+     * Example:
+     *
+     * @code{.cpp}
+     *
+     * static UsartDriver usarts[3];
+     *
+     * static IsrProvider::IrqHandlerArray<
+     *   UsartDriver,
+     *   Irq::USART1,
+     *   Irq::USART2,
+     *   Irq::USART3>
+     *   usart_irqs(usarts);
+     *
+     * @endcode
+     *
+     * @tparam Driver is a class of driver instances
+     * @tparam IRQS is a selected interrupts, one per instance
+     *
+     * @note Has same speed as IrqHandlerFixed
+     */
+    template<class Driver, Irq... IRQS>
+    class IrqHandlerArray
+    {
+     public:
+        static constexpr const size_t SIZE = sizeof...(IRQS);
+
+        IrqHandlerArray(Driver (&instances)[SIZE])
+        {
+            _instances = instances;
+
+            _register_irq_handlers(std::make_index_sequence<SIZE>{});
+        }
+
+        IrqHandlerArray(std::array<Driver, SIZE>& instances)
+        {
+            _instances = instances.data();
+
+            _register_irq_handlers(std::make_index_sequence<SIZE>{});
+        }
+
+        IrqHandlerArray(const IrqHandlerArray&) = delete;
+        IrqHandlerArray& operator=(const IrqHandlerArray&) = delete;
+        IrqHandlerArray(IrqHandlerArray&&) = delete;
+        IrqHandlerArray& operator=(IrqHandlerArray&&) = delete;
+
+     private:
+        template<size_t... INDEXES>
+        static void _register_irq_handlers(std::index_sequence<INDEXES...>)
+        {
+            (register_irq_handler(
+               IRQS, IrqHandlerArray<Driver, IRQS...>::call_irq<INDEXES>),
+             ...);
+        }
+
+        template<size_t INDEX>
+        static void call_irq()
+        {
+            constexpr Irq IRQ = std::array<Irq, SIZE>{IRQS...}[INDEX];
+
+            PrivateAccessor::template call<Driver, IRQ, false>(
+              _instances + INDEX);
+        }
+
+        static Driver* _instances;
+    };
 };
 
 // clang-format off
@@ -304,6 +421,14 @@ typename ServiceProvider<VT, Enum, S>::template IrqHandler<IrqHandlerHolder, IRQ
   ServiceProvider<VT, Enum, S>::IrqHandler<IrqHandlerHolder, IRQ>::
     _callable_handler = nullptr;
 
+/// Initialization of static variable _instances of class IrqHandlerArray
+template<uint32_t VT, typename Enum, class S>
+template<class Driver, Enum... IRQS>
+Driver*
+ServiceProvider<VT, Enum, S>::
+  IrqHandlerArray<Driver, IRQS...>::
+    _instances = nullptr;
+
 // clang-format on
 
 }  // namespace ramisr
@@ -0,0 +1,239 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+
+#include "../isr.hpp"
+
+namespace ramisr {
+
+namespace port {
+
+/**
+ * @brief Emulation of RAM vector tables and VTOR on a host
+ *
+ * Use it as IrqHandlerSetter of ServiceProvider to run holders
+ * without a hardware. VECTOR_TABLE_ADDRESS of such ServiceProvider
+ * is an index of an emulated table, not a real address:
+ *
+ * @code{.cpp}
+ *
+ * using Tables = ramisr::port::HostVectorTables<16, 2>;
+ * using IdleMode = ramisr::ServiceProvider<0, Irq, Tables>;
+ * using StreamingMode = ramisr::ServiceProvider<1, Irq, Tables>;
+ *
+ * StreamingMode::activate_vector_table();
+ * Tables::raise(uint8_t(Irq::DMA));  // calls a StreamingMode handler
+ *
+ * @endcode
+ *
+ * The active table index is an atomic, `activate` stores it with
+ * release semantics and `raise` loads it with acquire semantics,
+ * same as VTOR store plus barriers on a target, so `raise` may be
+ * called from any thread.
+ *
+ * A table index out of TABLES or a vector out of VECTORS aborts
+ * the program, e.g. a ServiceProvider with a real RAM address.
+ *
+ * @tparam VECTORS - count of vectors in each table
+ * @tparam TABLES - count of tables
+ */
+template<size_t VECTORS, size_t TABLES = 1>
+struct HostVectorTables
+{
+    HostVectorTables() = delete;
+
+    static void set(FreeFunc* vector_start, FreeFunc func, uint8_t func_shift)
+    {
+        const uintptr_t table = reinterpret_cast<uintptr_t>(vector_start);
+
+        _check(table < TABLES, "table index is out of range");
+        _check(func_shift < VECTORS, "vector is out of range");
+
+        tables[table][func_shift] = func;
+    }
+
+    static void activate(uint32_t vector_table_address)
+    {
+        _check(vector_table_address < TABLES, "table index is out of range");
+
+        active.store(vector_table_address, std::memory_order_release);
+    }
+
+    /**
+     * @brief Emulate an interrupt: call handler from the active table
+     *
+     * @return false if there is no handler for the interrupt
+     */
+    static bool raise(uint8_t irq)
+    {
+        _check(irq < VECTORS, "vector is out of range");
+
+        const FreeFunc handler =
+          tables[active.load(std::memory_order_acquire)][irq];
+
+        if (handler == nullptr) {
+            return false;
+        }
+
+        handler();
+
+        return true;
+    }
+
+    static inline FreeFunc tables[TABLES][VECTORS] = {};
+    static inline std::atomic<uint32_t> active{0};
+
+ private:
+    static void _check(bool is_ok, const char* message)
+    {
+        if (!is_ok) {
+            std::fprintf(stderr, "HostVectorTables: %s\n", message);
+            std::abort();
+        }
+    }
+};
+
+/**
+ * @brief Emulation of a core sleeping in WFI/WFE for IdleManager
+ *
+ * The thread calling `idle()` plays the core. Other threads raise
+ * interrupts with `raise`, which wakes the core up through a condition
+ * variable. Handlers from VectorTables are called by the sleeping
+ * thread, as a real core calls them before it returns from WFI.
+ * Interrupts raised while the core is awake are taken at its next
+ * sleep, so `disable_irq` and `enable_irq` have nothing to do.
+ *
+ * Time is measured in nanoseconds of `std::chrono::steady_clock`.
+ * `wake_time` is the moment when the interrupt being handled was
+ * raised, so IdleManager latency is raise-to-handler latency.
+ *
+ * @tparam VectorTables - HostVectorTables specialization
+ */
+template<class VectorTables>
+struct HostIdlePlatform
+{
+    using Time = uint64_t;
+
+    HostIdlePlatform() = delete;
+
+    static Time now()
+    {
+        return Time(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now().time_since_epoch())
+                      .count());
+    }
+
+    static Time wake_time() { return _raised_at; }
+
+    static void disable_irq() {}
+    static void enable_irq() {}
+
+    /**
+     * @brief Raise an interrupt (from any thread)
+     */
+    static void raise(uint8_t irq)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _pending.push_back({irq, now()});
+        }
+        _condition.notify_one();
+    }
+
+    /**
+     * @brief Wake up the core forever (e.g. before exit)
+     */
+    static void shutdown()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _is_shutdown = true;
+        }
+        _condition.notify_one();
+    }
+
+    /**
+     * @brief Forget pending interrupts and shutdown (between runs)
+     */
+    static void reset()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _pending.clear();
+        _is_event = false;
+        _is_shutdown = false;
+        _is_sleep_on_exit.store(false, std::memory_order_relaxed);
+    }
+
+    static void wait_for_interrupt() { _sleep(false); }
+
+    static void wait_for_event() { _sleep(true); }
+
+    static void send_event()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _is_event = true;
+        }
+        _condition.notify_one();
+    }
+
+    static void set_sleep_on_exit(bool is_enabled)
+    {
+        _is_sleep_on_exit.store(is_enabled, std::memory_order_relaxed);
+    }
+
+ private:
+    struct PendingIrq
+    {
+        uint8_t irq;
+        Time raised_at;
+    };
+
+    static void _sleep(bool is_wfe)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        // A latched event or a pending interrupt doesn't block the wait,
+        // but queued interrupts are still handled before the return
+        do {
+            _condition.wait(lock, [is_wfe] {
+                return !_pending.empty() || _is_shutdown ||
+                       (is_wfe && _is_event);
+            });
+
+            _is_event = false;
+
+            while (!_pending.empty()) {
+                const PendingIrq pending = _pending.front();
+                _pending.pop_front();
+
+                _raised_at = pending.raised_at;
+
+                lock.unlock();
+                VectorTables::raise(pending.irq);
+                lock.lock();
+            }
+        } while (_is_sleep_on_exit.load(std::memory_order_relaxed) &&
+                 !_is_shutdown);
+    }
+
+    static inline std::mutex _mutex;
+    static inline std::condition_variable _condition;
+    static inline std::deque<PendingIrq> _pending;
+    static inline bool _is_event = false;
+    static inline bool _is_shutdown = false;
+    static inline std::atomic<bool> _is_sleep_on_exit{false};
+    static inline Time _raised_at = 0;
+};
+
+}  // namespace port
+
+}  // namespace ramisr
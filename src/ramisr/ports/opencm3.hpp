@@ -4,14 +4,17 @@
 
 /// This headers should be provided by `libopencm3` library
 #include <libopencm3/cm3/nvic.h>
+#include <libopencm3/cm3/scb.h>
 #include <libopencm3/cm3/vector.h>
 #include <libopencmsis/core_cm3.h>
 
+#include "../isr.hpp"
+
 namespace irq {
 
 namespace port {
 
-inline static vector_table_t* move_vector_table_to_ram(
+inline static vector_table_t* copy_vector_table_to_ram(
   uint32_t table_rom_addr,
   uint32_t table_ram_addr)
 {
@@ -22,11 +25,82 @@ inline static vector_table_t* move_vector_table_to_ram(
     uint8_t* old_vec_table = reinterpret_cast<uint8_t*>(TABLE_ROM_ADDR);
     std::copy_n(old_vec_table, sizeof(vector_table), new_vec_table);
 
-    SCB->VTOR = TABLE_RAM_ADDR;
-
     return reinterpret_cast<vector_table_t*>(TABLE_RAM_ADDR);
 }
 
+inline static void activate_vector_table(uint32_t table_ram_addr)
+{
+    SCB->VTOR = table_ram_addr;
+
+    // New table must be used by the very next exception
+    __DSB();
+    __ISB();
+}
+
+inline static vector_table_t* move_vector_table_to_ram(
+  uint32_t table_rom_addr,
+  uint32_t table_ram_addr)
+{
+    auto* table = copy_vector_table_to_ram(table_rom_addr, table_ram_addr);
+
+    activate_vector_table(table_ram_addr);
+
+    return table;
+}
+
+/**
+ * @brief IrqHandlerSetter of ServiceProvider which can activate its table
+ *
+ * Needed for `ServiceProvider::activate_vector_table`.
+ */
+struct RamIrqHandlerSetter : ramisr::detail::DeafultRamIrqHandlerSetter
+{
+    static void activate(uint32_t vector_table_address)
+    {
+        activate_vector_table(vector_table_address);
+    }
+};
+
+/**
+ * @brief Platform of ramisr::IdleManager for Cortex-M3 cores
+ *
+ * Clock must provide `Time` type and `now()` and `wake_time()`
+ * static methods. Note that DWT cycle counter may be stopped in
+ * sleep, so use a timer which runs in sleep modes and captures
+ * the wake up moment for `wake_time()`.
+ */
+template<class Clock>
+struct IdlePlatform
+{
+    using Time = typename Clock::Time;
+
+    static Time now() { return Clock::now(); }
+    static Time wake_time() { return Clock::wake_time(); }
+
+    static void disable_irq() { __disable_irq(); }
+    static void enable_irq() { __enable_irq(); }
+
+    static void wait_for_interrupt()
+    {
+        __DSB();
+        __WFI();
+    }
+
+    static void wait_for_event() { __WFE(); }
+
+    static void send_event() { __SEV(); }
+
+    static void set_sleep_on_exit(bool is_enabled)
+    {
+        if (is_enabled) {
+            SCB_SCR |= SCB_SCR_SLEEPONEXIT;
+        }
+        else {
+            SCB_SCR &= ~SCB_SCR_SLEEPONEXIT;
+        }
+    }
+};
+
 }  // namespace port
 
 }  // namespace irq
\ No newline at end of file
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace ramisr {
+
+namespace detail {
+
+/**
+ * @brief Fences of SeqLock
+ *
+ * On a single Cortex-M core the writer is an interrupt which is never
+ * preempted by a reader, and the core observes its own accesses in
+ * program order, so only the compiler must not reorder them.
+ * Anywhere else (host threads) hardware fences are required.
+ */
+#if defined(__ARM_ARCH_PROFILE) && (__ARM_ARCH_PROFILE == 'M')
+inline void seqlock_fence(std::memory_order order)
+{
+    std::atomic_signal_fence(order);
+}
+#else
+inline void seqlock_fence(std::memory_order order)
+{
+    std::atomic_thread_fence(order);
+}
+#endif
+
+}  // namespace detail
+
+/**
+ * @brief Single-writer sequence lock
+ *
+ * Shares a multiword value written by an interrupt with thread code
+ * without masking interrupts. The writer is wait-free, readers retry
+ * while the value is being written.
+ *
+ * Sequence counter is odd while a write is in progress. A reader
+ * copies the value between two loads of the counter and retries if
+ * they differ. The value is kept as relaxed atomic words, so a torn
+ * copy is never used and there is no data race.
+ *
+ * Example of usage as a holder member:
+ *
+ * @code{.cpp}
+ *
+ * struct AdcSnapshot { uint16_t samples[4]; uint32_t timestamp; };
+ *
+ * // in the interrupt handler
+ * _snapshot.write(snapshot);
+ *
+ * // in thread code
+ * AdcSnapshot snapshot = holder.snapshot();  // returns _snapshot.read()
+ *
+ * @endcode
+ *
+ * @tparam T - trivially copyable value type
+ *
+ * @note Only one writer is allowed. With several writers protect
+ *       `write` by other means. E.g. a holder of several IRQs needs
+ *       a SeqLock per IRQ unless all of them have the same priority
+ *       and so never preempt each other.
+ */
+template<typename T>
+class SeqLock
+{
+    static_assert(
+      std::is_trivially_copyable_v<T>, "SeqLock value must be copied bytewise");
+
+    static constexpr const size_t WORDS =
+      (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+ public:
+    constexpr SeqLock() = default;
+
+    explicit SeqLock(const T& value) { write(value); }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+    SeqLock(SeqLock&&) = delete;
+    SeqLock& operator=(SeqLock&&) = delete;
+
+    /**
+     * @brief Publish a new value (the only writer)
+     */
+    void write(const T& value)
+    {
+        uint32_t words[WORDS] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        const uint32_t sequence = _sequence.load(std::memory_order_relaxed);
+
+        _sequence.store(sequence + 1, std::memory_order_relaxed);
+        detail::seqlock_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < WORDS; ++i) {
+            _words[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        _sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Try to copy the value once
+     *
+     * @return false if a write was in progress, `value` is not changed
+     */
+    bool try_read(T& value) const
+    {
+        const uint32_t sequence = _sequence.load(std::memory_order_acquire);
+        if (sequence & 1) {
+            return false;
+        }
+
+        uint32_t words[WORDS];
+        for (size_t i = 0; i < WORDS; ++i) {
+            words[i] = _words[i].load(std::memory_order_relaxed);
+        }
+
+        detail::seqlock_fence(std::memory_order_acquire);
+        if (_sequence.load(std::memory_order_relaxed) != sequence) {
+            return false;
+        }
+
+        std::memcpy(&value, words, sizeof(T));
+
+        return true;
+    }
+
+    /**
+     * @brief Copy the value, retrying while it is being written
+     *
+     * @note Never call it from an interrupt which preempts the writer,
+     *       it will spin forever.
+     */
+    T read() const
+    {
+        T value;
+        while (!try_read(value)) {
+        }
+
+        return value;
+    }
+
+    /**
+     * @brief Count of completed writes
+     */
+    uint32_t version() const
+    {
+        return _sequence.load(std::memory_order_acquire) / 2;
+    }
+
+ private:
+    std::atomic<uint32_t> _sequence{0};
+    std::atomic<uint32_t> _words[WORDS] = {};
+};
+
+}  // namespace ramisr
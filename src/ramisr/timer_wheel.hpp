@@ -0,0 +1,627 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+namespace ramisr {
+
+template<uint8_t, uint8_t, bool>
+class TimerWheel;
+
+namespace detail {
+
+struct TimerLink
+{
+    TimerLink* next;
+    TimerLink* prev;
+};
+
+inline void timer_link_init(TimerLink* head)
+{
+    head->next = head;
+    head->prev = head;
+}
+
+inline bool timer_link_is_empty(const TimerLink* head)
+{
+    return head->next == head;
+}
+
+inline void timer_link_unlink(TimerLink* link)
+{
+    link->prev->next = link->next;
+    link->next->prev = link->prev;
+}
+
+inline void timer_link_push_back(TimerLink* head, TimerLink* link)
+{
+    link->next = head;
+    link->prev = head->prev;
+    head->prev->next = link;
+    head->prev = link;
+}
+
+/// Moves all links from `from` to empty `to`
+inline void timer_link_splice(TimerLink* from, TimerLink* to)
+{
+    if (timer_link_is_empty(from)) {
+        timer_link_init(to);
+        return;
+    }
+
+    to->next = from->next;
+    to->prev = from->prev;
+    to->next->prev = to;
+    to->prev->next = to;
+
+    timer_link_init(from);
+}
+
+template<typename Bitmap>
+inline uint8_t count_trailing_zeros(Bitmap bitmap)
+{
+    if constexpr (sizeof(Bitmap) <= sizeof(unsigned)) {
+        return uint8_t(__builtin_ctz(bitmap));
+    }
+    else {
+        return uint8_t(__builtin_ctzll(bitmap));
+    }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Intrusive software timer
+ *
+ * Timer is a node of TimerWheel, so the wheel never allocates.
+ * Timer object must outlive its registration in a wheel and
+ * can't be copied or moved.
+ *
+ * @code{.cpp}
+ *
+ * void on_timeout(void* context) { }
+ *
+ * ramisr::Timer timeout(on_timeout, &protocol);
+ * wheel.start(timeout, 100);
+ *
+ * @endcode
+ */
+class Timer : detail::TimerLink
+{
+    template<uint8_t, uint8_t, bool>
+    friend class TimerWheel;
+
+ public:
+    using Callback = void (*)(void* context);
+
+    constexpr Timer(Callback callback, void* context = nullptr) :
+      detail::TimerLink{nullptr, nullptr},
+      _callback(callback),
+      _context(context)
+    {
+    }
+
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+    Timer(Timer&&) = delete;
+    Timer& operator=(Timer&&) = delete;
+
+    /**
+     * @brief True if the timer is started and not expired yet
+     */
+    bool is_active() const { return _slot != INACTIVE_SLOT; }
+
+    /**
+     * @brief Tick when the timer expires (valid if it is active)
+     */
+    uint32_t expires() const { return _expires; }
+
+ private:
+    static constexpr const uint16_t INACTIVE_SLOT = UINT16_MAX;
+
+    Callback _callback;
+    void* _context;
+
+    uint32_t _expires = 0;
+    uint16_t _slot = INACTIVE_SLOT;
+
+    /// Used only by a wheel with deferred callbacks
+    Timer* _deferred_next = nullptr;
+    std::atomic<bool> _is_deferred{false};
+};
+
+/**
+ * @brief Hierarchical timer wheel
+ *
+ * LEVELS wheels of 2^SLOT_BITS slots each. Level 0 slot is a list of
+ * timers expiring exactly at one tick, higher level slots hold timers
+ * for 2^(SLOT_BITS * level) ticks and are cascaded to the lower levels
+ * once per revolution of a lower level. Every non-empty slot is marked
+ * in a bitmap of its level, so searching of a next event is a couple
+ * of bit scans.
+ *
+ * Complexity:
+ *  - `start` and `stop` are O(1);
+ *  - `tick` is O(1) plus O(1) per expired timer plus O(1) per
+ *    cascaded timer. Amortized it is O(1) per timer, as every timer
+ *    is cascaded at most LEVELS - 1 times during its life. But a
+ *    single tick on a revolution of a lower level moves whole slots
+ *    of higher levels at once, so in the worst case it is O(N) for
+ *    N active timers, in the interrupt;
+ *  - `ticks_to_next_event` is O(LEVELS).
+ *
+ * Range of a timer is MAX_TICKS, longer timers are clamped.
+ *
+ * `start`, `stop`, `tick` and `advance` are not reentrant: call them
+ * from the tick interrupt (or callbacks) or with it masked.
+ * `run_deferred` is the only method safe to call from thread code
+ * concurrently with the tick interrupt.
+ *
+ * @tparam SLOT_BITS - log2 of slots count per level
+ * @tparam LEVELS - count of levels
+ * @tparam DEFER_CALLBACKS - if true than expired timers are queued
+ *         and their callbacks are called by `run_deferred` instead
+ *         of interrupt context. A timer is queued only once until
+ *         its callback is called, `stop` doesn't cancel it.
+ */
+template<
+  uint8_t SLOT_BITS = 5,
+  uint8_t LEVELS = 5,
+  bool DEFER_CALLBACKS = false>
+class TimerWheel
+{
+    static_assert(SLOT_BITS > 0 && SLOT_BITS <= 6, "Up to 64 slots per level");
+    static_assert(LEVELS > 0, "At least one level is required");
+    static_assert(
+      SLOT_BITS * LEVELS < 32, "Wheel range must fit in a signed tick");
+
+    using Bitmap =
+      std::conditional_t<(SLOT_BITS <= 5), uint32_t, unsigned long long>;
+
+    static constexpr const uint32_t SLOTS = 1u << SLOT_BITS;
+    static constexpr const uint32_t SLOT_MASK = SLOTS - 1;
+
+ public:
+    static constexpr const uint32_t MAX_TICKS =
+      (1u << (SLOT_BITS * LEVELS)) - 1;
+
+    /// Returned by `ticks_to_next_event` if there are no timers
+    static constexpr const uint32_t NO_EVENT = UINT32_MAX;
+
+    TimerWheel()
+    {
+        for (auto& slot : _slots) {
+            detail::timer_link_init(&slot);
+        }
+    }
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+    TimerWheel(TimerWheel&&) = delete;
+    TimerWheel& operator=(TimerWheel&&) = delete;
+
+    /**
+     * @brief Current tick of the wheel
+     */
+    uint32_t now() const { return _now; }
+
+    /**
+     * @brief Start (or restart) a timer
+     *
+     * @param timer - timer to start
+     * @param ticks - timer expires after this count of ticks,
+     *        0 is treated as 1 and more than MAX_TICKS as MAX_TICKS
+     */
+    void start(Timer& timer, uint32_t ticks)
+    {
+        stop(timer);
+
+        timer._expires = _now + std::clamp<uint32_t>(ticks, 1, MAX_TICKS);
+        _insert(&timer);
+    }
+
+    /**
+     * @brief Stop a timer
+     *
+     * @return true if the timer was active
+     */
+    bool stop(Timer& timer)
+    {
+        if (!timer.is_active()) {
+            return false;
+        }
+
+        detail::timer_link_unlink(&timer);
+
+        const uint16_t slot = timer._slot;
+        if (detail::timer_link_is_empty(&_slots[slot])) {
+            _bitmaps[slot >> SLOT_BITS] &= ~(Bitmap(1) << (slot & SLOT_MASK));
+        }
+
+        timer._slot = Timer::INACTIVE_SLOT;
+
+        return true;
+    }
+
+    /**
+     * @brief Advance the wheel by one tick and expire timers
+     */
+    void tick()
+    {
+        ++_now;
+
+        const uint32_t index = _now & SLOT_MASK;
+
+        if (index == 0) {
+            _cascade();
+        }
+
+        _expire(index);
+    }
+
+    /**
+     * @brief Advance the wheel by any count of ticks
+     *
+     * Ticks without expirations or cascades are skipped, so cost
+     * doesn't depend on `ticks` but on a count of expired timers
+     * and cascaded slots.
+     */
+    void advance(uint32_t ticks)
+    {
+        while (ticks > 0) {
+            const uint32_t step = std::min(ticks, ticks_to_next_event());
+
+            _now += step - 1;
+            tick();
+
+            ticks -= step;
+        }
+    }
+
+    /**
+     * @brief Count of ticks until the wheel has some work
+     *
+     * It is a tick when a timer of level 0 expires or when a slot of
+     * a higher level has to be cascaded, whichever is earlier. A slot
+     * of level N is cascaded only on a tick which is a multiple of
+     * SLOTS^N, so the result is never later than the nearest timer.
+     * Intended for programming of a tickless timer.
+     *
+     * @return count of ticks or NO_EVENT if there are no timers
+     */
+    uint32_t ticks_to_next_event() const
+    {
+        uint32_t ticks = NO_EVENT;
+
+        for (uint8_t level = 0; level < LEVELS; ++level) {
+            if (_bitmaps[level] == 0) {
+                continue;
+            }
+
+            // Next tick of the level, in its slot units
+            const uint8_t shift = SLOT_BITS * level;
+            const uint32_t next = (_now >> shift) + 1;
+
+            const uint32_t event =
+              (next + _slots_to_next(_bitmaps[level], next & SLOT_MASK))
+              << shift;
+
+            ticks = std::min(ticks, event - _now);
+        }
+
+        return ticks;
+    }
+
+    /**
+     * @brief Call callbacks of expired timers (DEFER_CALLBACKS only)
+     *
+     * Callbacks are called in order of expiration.
+     *
+     * @return count of called callbacks
+     */
+    uint32_t run_deferred()
+    {
+        static_assert(DEFER_CALLBACKS, "Callbacks are not deferred");
+
+        Timer* stack = _deferred.exchange(nullptr, std::memory_order_acquire);
+
+        Timer* queue = nullptr;
+        while (stack != nullptr) {
+            Timer* next = stack->_deferred_next;
+            stack->_deferred_next = queue;
+            queue = stack;
+            stack = next;
+        }
+
+        uint32_t count = 0;
+        while (queue != nullptr) {
+            Timer* timer = queue;
+            queue = timer->_deferred_next;
+
+            timer->_is_deferred.store(false, std::memory_order_release);
+            timer->_callback(timer->_context);
+
+            ++count;
+        }
+
+        return count;
+    }
+
+ private:
+    void _insert(Timer* timer)
+    {
+        const uint32_t delta = timer->_expires - _now;
+
+        uint8_t level = 0;
+        while (level + 1 < LEVELS &&
+               delta >= (1u << (SLOT_BITS * (level + 1)))) {
+            ++level;
+        }
+
+        const uint32_t index =
+          (timer->_expires >> (SLOT_BITS * level)) & SLOT_MASK;
+        const uint16_t slot = uint16_t((level << SLOT_BITS) | index);
+
+        detail::timer_link_push_back(&_slots[slot], timer);
+        _bitmaps[level] |= Bitmap(1) << index;
+
+        timer->_slot = slot;
+    }
+
+    /// Count of slots from `index` to the next set one, wrapping around
+    static uint32_t _slots_to_next(Bitmap bitmap, uint32_t index)
+    {
+        const Bitmap ahead = bitmap >> index;
+        if (ahead != 0) {
+            return detail::count_trailing_zeros(ahead);
+        }
+
+        return SLOTS - index + detail::count_trailing_zeros(bitmap);
+    }
+
+    /// Moves timers of current slots of higher levels down
+    void _cascade()
+    {
+        for (uint8_t level = 1; level < LEVELS; ++level) {
+            const uint32_t index = (_now >> (SLOT_BITS * level)) & SLOT_MASK;
+            const uint16_t slot = uint16_t((level << SLOT_BITS) | index);
+
+            detail::TimerLink pending;
+            detail::timer_link_splice(&_slots[slot], &pending);
+            _bitmaps[level] &= ~(Bitmap(1) << index);
+
+            while (!detail::timer_link_is_empty(&pending)) {
+                auto* timer = static_cast<Timer*>(pending.next);
+                detail::timer_link_unlink(timer);
+                _insert(timer);
+            }
+
+            if (index != 0) {
+                break;
+            }
+        }
+    }
+
+    void _expire(uint32_t index)
+    {
+        if ((_bitmaps[0] & (Bitmap(1) << index)) == 0) {
+            return;
+        }
+
+        // Callbacks may start or stop any timers, including expiring ones
+        detail::TimerLink expired;
+        detail::timer_link_splice(&_slots[index], &expired);
+        _bitmaps[0] &= ~(Bitmap(1) << index);
+
+        while (!detail::timer_link_is_empty(&expired)) {
+            auto* timer = static_cast<Timer*>(expired.next);
+            detail::timer_link_unlink(timer);
+            timer->_slot = Timer::INACTIVE_SLOT;
+
+            if constexpr (DEFER_CALLBACKS) {
+                _defer(timer);
+            }
+            else {
+                timer->_callback(timer->_context);
+            }
+        }
+    }
+
+    void _defer(Timer* timer)
+    {
+        // Pairs with the release in `run_deferred`: it has read
+        // `_deferred_next` before the timer can be queued again
+        if (timer->_is_deferred.exchange(true, std::memory_order_acquire)) {
+            return;
+        }
+
+        timer->_deferred_next = _deferred.load(std::memory_order_relaxed);
+        while (!_deferred.compare_exchange_weak(
+          timer->_deferred_next, timer, std::memory_order_release,
+          std::memory_order_relaxed)) {
+        }
+    }
+
+    uint32_t _now = 0;
+
+    Bitmap _bitmaps[LEVELS] = {};
+    detail::TimerLink _slots[SLOTS * LEVELS];
+
+    std::atomic<Timer*> _deferred{nullptr};
+};
+
+/**
+ * @brief Tick source of a periodic tick interrupt
+ *
+ * The wheel is advanced by one tick per interrupt.
+ */
+struct PeriodicTickSource
+{
+    static constexpr const bool IS_TICKLESS = false;
+};
+
+/**
+ * @brief Timer wheel service packaged as a tick interrupt holder
+ *
+ * Register it once (usually for SysTick) as a static object and
+ * start timers through it:
+ *
+ * @code{.cpp}
+ *
+ * using SysTickTimers =
+ *   ramisr::TimerWheelHolder<IsrProvider, IsrProvider::Irq::SYS_TICK>;
+ *
+ * static SysTickTimers timers;
+ * timers.start(timeout, 100);
+ *
+ * @endcode
+ *
+ * Tickless mode is enabled by TickSource with `IS_TICKLESS = true`.
+ * It must provide:
+ *
+ * @code{.cpp}
+ *
+ * struct SysTickTickless
+ * {
+ *     static constexpr const bool IS_TICKLESS = true;
+ *
+ *     // Longest period which can be programmed
+ *     static constexpr const uint32_t MAX_TICKS = 0xFFFFFF / TICK_CYCLES;
+ *
+ *     // Next interrupt must happen after `ticks` ticks from now
+ *     static void program(uint32_t ticks);
+ *
+ *     // Ticks passed since the last `program` call
+ *     static uint32_t elapsed();
+ * };
+ *
+ * @endcode
+ *
+ * In tickless mode the interrupt is programmed to the next event of
+ * the wheel and `start` reprograms it if a new timer is earlier.
+ * Started from a callback, a timer counts from its expiration tick.
+ *
+ * Same as for TimerWheel, `start` and `stop` must be called from the
+ * interrupt (or callbacks) or with it masked.
+ *
+ * @tparam IsrProvider - ServiceProvider specialization
+ * @tparam IRQ - tick interrupt
+ * @tparam Wheel - TimerWheel specialization
+ * @tparam TickSource - PeriodicTickSource or a tickless source
+ */
+template<
+  class IsrProvider,
+  typename IsrProvider::Irq IRQ,
+  class Wheel = TimerWheel<>,
+  class TickSource = PeriodicTickSource>
+class TimerWheelHolder
+  : IsrProvider::template IrqHandlerFixed<
+      TimerWheelHolder<IsrProvider, IRQ, Wheel, TickSource>,
+      IRQ>
+{
+    using IrqHandler = typename IsrProvider::template IrqHandlerFixed<
+      TimerWheelHolder<IsrProvider, IRQ, Wheel, TickSource>,
+      IRQ>;
+
+    //<! Needed because call_irq_handler is private
+    friend typename IsrProvider::PrivateAccessor;
+
+ public:
+    TimerWheelHolder() : IrqHandler(this)
+    {
+        if constexpr (TickSource::IS_TICKLESS) {
+            TickSource::program(_deadline);
+        }
+    }
+
+    /**
+     * @brief Start (or restart) a timer, see TimerWheel::start
+     */
+    void start(Timer& timer, uint32_t ticks)
+    {
+        if constexpr (TickSource::IS_TICKLESS) {
+            // From a callback the wheel is already advanced and
+            // the interrupt is reprogrammed after all callbacks
+            if (_is_handling) {
+                _wheel.start(timer, ticks);
+                return;
+            }
+
+            // The wheel is advanced only in the interrupt,
+            // so it is behind by elapsed ticks
+            const uint32_t elapsed = _offset + TickSource::elapsed();
+            const uint32_t delay = std::min(
+              std::max<uint32_t>(ticks, 1), Wheel::MAX_TICKS - elapsed);
+
+            _wheel.start(timer, delay + elapsed);
+
+            if (delay + elapsed < _deadline) {
+                _deadline = delay + elapsed;
+                _offset = elapsed;
+                TickSource::program(delay);
+            }
+        }
+        else {
+            _wheel.start(timer, ticks);
+        }
+    }
+
+    /**
+     * @brief Stop a timer, see TimerWheel::stop
+     */
+    bool stop(Timer& timer) { return _wheel.stop(timer); }
+
+    /**
+     * @brief Call deferred callbacks, see TimerWheel::run_deferred
+     */
+    uint32_t run_deferred() { return _wheel.run_deferred(); }
+
+    /**
+     * @brief Current tick of the wheel
+     *
+     * In tickless mode it is updated only by the interrupt.
+     */
+    uint32_t now() const { return _wheel.now(); }
+
+ private:
+    void call_irq_handler()
+    {
+        if constexpr (TickSource::IS_TICKLESS) {
+            _is_handling = true;
+            _wheel.advance(_deadline);
+            _is_handling = false;
+
+            _deadline = std::min(_wheel.ticks_to_next_event(), max_deadline());
+            _offset = 0;
+            TickSource::program(_deadline);
+        }
+        else {
+            _wheel.tick();
+        }
+    }
+
+    Wheel _wheel;
+
+    /// Ticks from `now()` to the programmed interrupt (tickless only)
+    uint32_t _deadline = TickSource::IS_TICKLESS ? max_deadline() : 0;
+
+    /// Ticks from `now()` to the last `program` call (tickless only)
+    uint32_t _offset = 0;
+
+    /// Callbacks are running from the interrupt (tickless only)
+    bool _is_handling = false;
+
+    static constexpr uint32_t max_deadline()
+    {
+        if constexpr (TickSource::IS_TICKLESS) {
+            return std::min(TickSource::MAX_TICKS, Wheel::MAX_TICKS);
+        }
+        else {
+            return 0;
+        }
+    }
+};
+
+}  // namespace ramisr